@@ -4,3 +4,6 @@
 
 #include "CoreMinimal.h"
 
+
+// Stat group for the per-frame hand query batch. Use "stat HandQueries" in the console to view.
+DECLARE_STATS_GROUP(TEXT("HandQueries"), STATGROUP_HandQueries, STATCAT_Advanced);
@@ -7,6 +7,9 @@
 #include <GameFramework/PlayerController.h>
 #include "GameFramework/CharacterMovementComponent.h"
 #include <GameFramework/Character.h>
+#include "ArchitectureExplorer.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Climb Queries"), STAT_ClimbQueries, STATGROUP_HandQueries);
 
 // Sets default values
 AHandController::AHandController()
@@ -33,6 +36,10 @@ void AHandController::BeginPlay()
 void AHandController::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+
+	// Resolve this frame's overlap changes with a single climb query
+	if (bClimbQueryPending) { UpdateCanClimb(); }
+
 	if (bIsClimbing)
 	{
 		FVector HandControllerDelta = GetActorLocation() - CLimbingStartingLocation;
@@ -48,6 +55,8 @@ void AHandController::PairController(AHandController* Controller)
 
 void AHandController::Grip()
 {
+	// Input can arrive before this frame's query batch, so resolve any pending overlap change now
+	if (bClimbQueryPending) { UpdateCanClimb(); }
 	if (!bCanClimb) { return; }
 
 	if (!bIsClimbing)
@@ -78,21 +87,35 @@ void AHandController::Release()
 
 void AHandController::ActorBeginOverlap(AActor* OverlappedActor, AActor* OtherActor)
 {
-	if (!PlayerController) { UE_LOG(LogTemp, Warning, TEXT("No Player Controller")) return; }
-	
+	bClimbQueryPending = true;
+}
+
+void AHandController::ActorEndOverlap(AActor* OverlappedActor, AActor* OtherActor)
+{
+	bClimbQueryPending = true;
+}
+
+// Several overlap events in one frame cost a single overlap query
+void AHandController::UpdateCanClimb()
+{
+	bClimbQueryPending = false;
+	INC_DWORD_STAT(STAT_ClimbQueries);
+
 	bool bNewCanClimb = CanClimb();
 	if (!bCanClimb && bNewCanClimb)
 	{
-		PlayerController->PlayHapticEffect(HapticEffect, MotionController->GetTrackingSource());
+		if (PlayerController != nullptr)
+		{
+			PlayerController->PlayHapticEffect(HapticEffect, MotionController->GetTrackingSource());
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("No Player Controller"))
+		}
 	}
 	bCanClimb = bNewCanClimb;
 }
 
-void AHandController::ActorEndOverlap(AActor* OverlappedActor, AActor* OtherActor)
-{
-	bCanClimb = CanClimb();
-}
-
 bool AHandController::CanClimb() const
 {
 	TArray<AActor*> OverLappingActors;
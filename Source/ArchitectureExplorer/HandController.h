@@ -29,6 +29,7 @@ public:
 public:
 	// Public Functions for setting up our controller
 	void SetHand(EControllerHand Hand) { MotionController->SetTrackingSource(Hand); }
+	UMotionControllerComponent* GetMotionController() const { return MotionController; }
 	void PairController(AHandController* Controller);
 	void Grip();
 	void Release();
@@ -42,6 +43,9 @@ private:
 	UFUNCTION()
 	void ActorEndOverlap(AActor* OverlappedActor, AActor* OtherActor);
 
+	// Overlap events only mark a climb-reach query as pending; Tick() resolves it at most once per frame
+	// and Grip() resolves it immediately. The haptic pulse fires when the query resolves.
+	void UpdateCanClimb();
 	bool CanClimb() const;
 //------------------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -61,6 +65,7 @@ private:
 	AHandController* OtherController;
 
 	bool bCanClimb = false;
+	bool bClimbQueryPending = false;	// Set by overlap events, resolved once per frame in UpdateCanClimb()
 	bool bIsClimbing = false;
 	FVector CLimbingStartingLocation;
 
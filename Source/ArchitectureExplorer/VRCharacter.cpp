@@ -1,6 +1,7 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "VRCharacter.h"
+#include "ArchitectureExplorer.h"
 #include <Camera/CameraComponent.h>
 #include <Components/InputComponent.h>
 #include <Components/SceneComponent.h>
@@ -13,11 +14,17 @@
 #include <Materials/MaterialInstanceDynamic.h>
 #include <MotionControllerComponent.h>
 #include <XRMotionControllerBase.h>
-#include <Kismet/GameplayStatics.h>
+#include <Engine/World.h>
 #include <Components/SplineComponent.h>
 #include <Components/SplineMeshComponent.h>
 #include "HandController.h"
 
+DECLARE_CYCLE_STAT(TEXT("Hand Query Batch"), STAT_HandQueryBatch, STATGROUP_HandQueries);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Arcs Submitted"), STAT_ArcsSubmitted, STATGROUP_HandQueries);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Arc Segment Sweeps"), STAT_ArcSegmentSweeps, STATGROUP_HandQueries);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sync Arcs"), STAT_SyncArcs, STATGROUP_HandQueries);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Nav Projections"), STAT_NavProjections, STATGROUP_HandQueries);
+
 // Sets default values
 AVRCharacter::AVRCharacter()
 {
@@ -69,6 +76,10 @@ void AVRCharacter::BeginPlay()
 
 	LeftMotionController->PairController(RightMotionController);
 
+	// Make sure the query batch runs after both motion controller poses have updated
+	AddTickPrerequisiteComponent(LeftMotionController->GetMotionController());
+	AddTickPrerequisiteComponent(RightMotionController->GetMotionController());
+
 	// Setup of our Blinker Material
 	TeleportDesinationMarker->SetVisibility(false);
 	
@@ -95,65 +106,207 @@ void AVRCharacter::Tick(float DeltaTime)
 	AddActorWorldOffset(VRCameraOffset);	// Move Character with Capsule Component attached to VRCamera location
 	VRRoot->AddWorldOffset(-VRCameraOffset);	// Move VRRoot back to original location (middle of our play space).
  
+	RunHandQueryBatch();
 	UpdateDestinationMarker();
 	if (bCanUseBlinkers == true) { UpdateBlinkers(); }
 }
 
 void AVRCharacter::UpdateDestinationMarker()
 {
-	FVector Location;
-	TArray<FVector> Path;
-	bool bHasDeistinastion = FindTeleportDestination(Path, Location);
+	const FHandTeleportQuery& Query = GetTeleportQuery(ActiveTeleportHand);
 
-	// If we hit something and were on the NavMesh
-	if (bHasDeistinastion)
+	// If the aiming hand hit something and were on the NavMesh
+	if (Query.bHasDestination)
 	{
-		bCanTeleport = true;
 		TeleportDesinationMarker->SetVisibility(true);
-		TeleportDesinationMarker->SetWorldLocation(Location);		// Move our marker
-		DrawTeleportPath(Path);
+		TeleportDesinationMarker->SetWorldLocation(Query.Destination);		// Move our marker
+		DrawTeleportPath(Query.Path);
 	}
 	else
 	{
 		TArray<FVector> EmptyPath;
-		bCanTeleport = false;
 		TeleportDesinationMarker->SetVisibility(false);		// Turn off our marker
 		DrawTeleportPath(EmptyPath);
 	}
 }
 
-// Use PredictProjectilePath() to get a Parabolic curve for a visual guide for teleporting onto our NavMesh
-bool AVRCharacter::FindTeleportDestination(TArray<FVector>& OutPath, FVector& OutLocation)
+// Gather every hand's arc sweep and nav projection for this frame and submit them together.
+// Arc segments are submitted as async sweeps that run on the physics worker threads alongside the rest of the
+// frame; their results are collected here on the next frame, so the previewed arc is one frame behind the hand.
+// Runs after the motion controller poses have updated (see the tick prerequisites set up in BeginPlay).
+void AVRCharacter::RunHandQueryBatch()
 {
-	FVector Start = LeftMotionController->GetActorLocation();
-	FVector Look = LeftMotionController->GetActorForwardVector();
-	
-	FPredictProjectilePathParams PredictParams(
-		TeleportProjectileRadius,
-		Start,
-		Look * TeleportProjectileSpeed,
-		TeleportSimulationTime,
-		ECollisionChannel::ECC_Camera,
-		this);
-	
-	FPredictProjectilePathResult PredictResult;
-	bool bHit = UGameplayStatics::PredictProjectilePath(this, PredictParams, PredictResult);
+	SCOPE_CYCLE_COUNTER(STAT_HandQueryBatch);
 
-	if (!bHit) return false;
+	UWorld* World = GetWorld();
+	UNavigationSystemV1* NavigationSystem = UNavigationSystemV1::GetNavigationSystem(World);
 
-	for (FPredictProjectilePathPointData PointData: PredictResult.PathData)
+	// Collect last frame's sweeps, then work out which hands need a fresh arc submitted this frame
+	TArray<FHandTeleportQuery*, TInlineAllocator<2>> PendingSweeps;
+	for (int32 Index = 0; Index < ARRAY_COUNT(TeleportQueries); ++Index)
 	{
-		OutPath.Add(PointData.Location);
+		FHandTeleportQuery& Query = TeleportQueries[Index];
+		AHandController* Hand = GetHandController(Index);
+		if (Hand == nullptr) { continue; }
+
+		if (Query.SweepHandles.Num() > 0)
+		{
+			CollectTeleportSweep(Query, NavigationSystem);
+		}
+
+		// Only the previewed hand and any hand holding its teleport button need an arc
+		bool bIsActive = Index == GetHandIndex(ActiveTeleportHand);
+		if (!Query.bIsAiming && !bIsActive)
+		{
+			Query.bHasResult = false;
+			Query.bHasDestination = false;
+			Query.LastHitSegment = INDEX_NONE;
+			continue;
+		}
+
+		// A held hand that is not previewed is only used if aiming passes to it, so it refreshes at a reduced rate
+		if (!bIsActive && Query.bHasResult && ++Query.FramesSinceSubmit < TeleportSecondaryHandInterval) { continue; }
+		Query.FramesSinceSubmit = 0;
+
+		BuildTeleportArc(Query, Hand);
+		PendingSweeps.Add(&Query);
 	}
 
-	UNavigationSystemV1* NavigationSystem = UNavigationSystemV1::GetNavigationSystem(GetWorld());
-	FNavLocation NavLocation;
-	bool bOnNavMesh = NavigationSystem->ProjectPointToNavigation(PredictResult.HitResult.Location, NavLocation, TeleportProjectionExtent);
+	if (PendingSweeps.Num() == 0) { return; }
+
+	// Submit: every hand's arc goes to the async trace queue in one pass, one sphere sweep per arc segment
+	FCollisionQueryParams QueryParams(FName(TEXT("TeleportArc")), false, this);
+	FCollisionShape Sphere = FCollisionShape::MakeSphere(TeleportProjectileRadius);
+
+	for (FHandTeleportQuery* Query : PendingSweeps)
+	{
+		int32 SegmentNum = Query->ArcPoints.Num() - 1;
+
+		// Async sweeps cannot stop at the first hit, so only sweep a few segments past last frame's hit
+		int32 SweepNum = SegmentNum;
+		if (Query->LastHitSegment != INDEX_NONE)
+		{
+			SweepNum = FMath::Min(SegmentNum, Query->LastHitSegment + 1 + TeleportSweepSegmentMargin);
+		}
+
+		Query->SweepHandles.Reset(SweepNum);
+		for (int32 i = 0; i < SweepNum; ++i)
+		{
+			Query->SweepHandles.Add(World->AsyncSweepByChannel(EAsyncTraceType::Single, Query->ArcPoints[i], Query->ArcPoints[i + 1],
+				ECollisionChannel::ECC_Camera, Sphere, QueryParams));
+		}
+
+		INC_DWORD_STAT(STAT_ArcsSubmitted);
+		INC_DWORD_STAT_BY(STAT_ArcSegmentSweeps, SweepNum);
+	}
+}
+
+// Work out the segment end points of the parabola launched from the hand's current pose
+void AVRCharacter::BuildTeleportArc(FHandTeleportQuery& Query, AHandController* Hand)
+{
+	Query.Start = Hand->GetActorLocation();
+	Query.Look = Hand->GetActorForwardVector();
+
+	FVector LaunchVelocity = Query.Look * TeleportProjectileSpeed;
+	float GravityZ = GetWorld()->GetGravityZ();
+	int32 SegmentNum = FMath::Max(1, FMath::CeilToInt(TeleportSimulationTime * TeleportSimulationFrequency));
+	float SegmentTime = TeleportSimulationTime / SegmentNum;
+
+	Query.ArcPoints.Reset(SegmentNum + 1);
+	for (int32 i = 0; i <= SegmentNum; ++i)
+	{
+		float Time = i * SegmentTime;
+		Query.ArcPoints.Add(Query.Start + LaunchVelocity * Time + FVector(0.f, 0.f, .5f * GravityZ * Time * Time));
+	}
+}
+
+// Walk a hand's arc segments in order; the first blocking hit ends the path
+void AVRCharacter::CollectTeleportSweep(FHandTeleportQuery& Query, UNavigationSystemV1* NavigationSystem)
+{
+	int32 SweepNum = Query.SweepHandles.Num();
+	bool bCapped = SweepNum < Query.ArcPoints.Num() - 1;
+
+	int32 HitSegment = INDEX_NONE;
+	FVector HitLocation;
+	for (int32 i = 0; i < SweepNum; ++i)
+	{
+		FTraceDatum TraceData;
+		if (GetWorld()->QueryTraceData(Query.SweepHandles[i], TraceData) && TraceData.OutHits.Num() > 0 && TraceData.OutHits[0].bBlockingHit)
+		{
+			HitSegment = i;
+			HitLocation = TraceData.OutHits[0].Location;
+			break;
+		}
+	}
+	Query.SweepHandles.Reset();
+
+	// A capped sweep that found nothing keeps the previous result; the next submission sweeps the whole arc
+	if (HitSegment == INDEX_NONE && bCapped)
+	{
+		Query.LastHitSegment = INDEX_NONE;
+		return;
+	}
+
+	ApplyTeleportHit(Query, HitSegment, HitLocation, NavigationSystem);
+}
+
+// Sweep a hand's arc on the game thread, stopping at the first hit, so a hand that has just become the
+// aiming hand has a result this frame instead of waiting for the next batch to be collected
+void AVRCharacter::SweepTeleportArcNow(EControllerHand Hand)
+{
+	AHandController* HandController = GetHandController(GetHandIndex(Hand));
+	if (HandController == nullptr) { return; }
+
+	FHandTeleportQuery& Query = GetTeleportQuery(Hand);
+	BuildTeleportArc(Query, HandController);
+	Query.SweepHandles.Reset();		// Anything still in flight was swept from an older pose
+	Query.FramesSinceSubmit = 0;
+
+	FCollisionQueryParams QueryParams(FName(TEXT("TeleportArc")), false, this);
+	FCollisionShape Sphere = FCollisionShape::MakeSphere(TeleportProjectileRadius);
+
+	int32 HitSegment = INDEX_NONE;
+	FVector HitLocation;
+	for (int32 i = 0; i < Query.ArcPoints.Num() - 1; ++i)
+	{
+		INC_DWORD_STAT(STAT_ArcSegmentSweeps);
+
+		FHitResult HitResult;
+		if (GetWorld()->SweepSingleByChannel(HitResult, Query.ArcPoints[i], Query.ArcPoints[i + 1], FQuat::Identity,
+			ECollisionChannel::ECC_Camera, Sphere, QueryParams))
+		{
+			HitSegment = i;
+			HitLocation = HitResult.Location;
+			break;
+		}
+	}
+	INC_DWORD_STAT(STAT_SyncArcs);
 
-	if (!bOnNavMesh) return false;
+	ApplyTeleportHit(Query, HitSegment, HitLocation, UNavigationSystemV1::GetNavigationSystem(GetWorld()));
+}
 
-	OutLocation = NavLocation.Location;
-	return true;
+// Store a hand's arc up to its hit and project the hit onto the NavMesh
+void AVRCharacter::ApplyTeleportHit(FHandTeleportQuery& Query, int32 HitSegment, const FVector& HitLocation, UNavigationSystemV1* NavigationSystem)
+{
+	Query.bHasResult = true;
+	Query.bHasDestination = false;
+	Query.LastHitSegment = HitSegment;
+	Query.Path.Reset();
+	if (HitSegment == INDEX_NONE) { return; }
+
+	for (int32 i = 0; i <= HitSegment; ++i)
+	{
+		Query.Path.Add(Query.ArcPoints[i]);
+	}
+	Query.HitLocation = HitLocation;
+	Query.Path.Add(HitLocation);
+
+	if (NavigationSystem == nullptr) { return; }
+
+	FNavLocation NavLocation;
+	Query.bHasDestination = NavigationSystem->ProjectPointToNavigation(Query.HitLocation, NavLocation, TeleportProjectionExtent);
+	Query.Destination = NavLocation.Location;
+	INC_DWORD_STAT(STAT_NavProjections);
 }
 
 void AVRCharacter::DrawTeleportPath(const TArray<FVector>& Path)
@@ -263,7 +416,10 @@ void AVRCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCompone
 
 	PlayerInputComponent->BindAxis(TEXT("MoveLeft_Y"), this, &AVRCharacter::MoveForward);
 	PlayerInputComponent->BindAxis(TEXT("MoveLeft_X"), this, &AVRCharacter::MoveRight);
-	PlayerInputComponent->BindAction(TEXT("TelePortLeft"), IE_Released, this, &AVRCharacter::BeginTelePort);
+	PlayerInputComponent->BindAction(TEXT("TeleportLeft"), IE_Pressed, this, &AVRCharacter::AimTeleportLeft);
+	PlayerInputComponent->BindAction(TEXT("TeleportRight"), IE_Pressed, this, &AVRCharacter::AimTeleportRight);
+	PlayerInputComponent->BindAction(TEXT("TeleportLeft"), IE_Released, this, &AVRCharacter::ReleaseTeleportLeft);
+	PlayerInputComponent->BindAction(TEXT("TeleportRight"), IE_Released, this, &AVRCharacter::ReleaseTeleportRight);
 	PlayerInputComponent->BindAction(TEXT("GrabLeft"), IE_Pressed, this, &AVRCharacter::GripLeft);
 	PlayerInputComponent->BindAction(TEXT("GrabRight"), IE_Pressed, this, &AVRCharacter::GripRight);
 	PlayerInputComponent->BindAction(TEXT("GrabLeft"), IE_Released, this, &AVRCharacter::ReleaseLeft);
@@ -281,9 +437,35 @@ void AVRCharacter::MoveRight(float Throttle)
 	AddMovementInput(VRCamera->GetRightVector(), Throttle);
 }
 
+// Pressing teleport on either hand makes it the aiming hand
+void AVRCharacter::AimTeleport(EControllerHand Hand)
+{
+	FHandTeleportQuery& Query = GetTeleportQuery(Hand);
+	Query.bIsAiming = true;
+	ActiveTeleportHand = Hand;
+
+	// Batched results arrive a frame late, so resolve a hand with no arc yet right away to keep the marker showing
+	if (!Query.bHasResult) { SweepTeleportArcNow(Hand); }
+}
+
+// Releasing teleport on the aiming hand teleports to that hand's own destination
+void AVRCharacter::ReleaseTeleport(EControllerHand Hand)
+{
+	FHandTeleportQuery& Query = GetTeleportQuery(Hand);
+	Query.bIsAiming = false;
+	if (Hand != ActiveTeleportHand) { return; }
+
+	// Hand aiming over to the other hand if it is still held
+	EControllerHand OtherHand = (Hand == EControllerHand::Left) ? EControllerHand::Right : EControllerHand::Left;
+	if (GetTeleportQuery(OtherHand).bIsAiming) { ActiveTeleportHand = OtherHand; }
+
+	if (!Query.bHasDestination) { return; }
+	TeleportDestination = Query.Destination;
+	BeginTelePort();
+}
+
 void AVRCharacter::BeginTelePort()
 {
-	if (!bCanTeleport) { return; }
 	StartFade(0, 1);	// Fade camera out
 
 	// Timer Setup so we can fade out before we move to new location.
@@ -293,7 +475,7 @@ void AVRCharacter::BeginTelePort()
 
 void AVRCharacter::EndTeleport()
 {
-	FVector Destination = TeleportDesinationMarker->GetComponentLocation();
+	FVector Destination = TeleportDestination;
 	Destination += GetCapsuleComponent()->GetScaledCapsuleHalfHeight() * GetActorUpVector();
 
 	StartFade(1, 0);	// Fade camera in
@@ -4,9 +4,27 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include <WorldCollision.h>
 #include "HandController.h"
 #include "VRCharacter.generated.h"
 
+// Per-hand teleport state gathered into the character's per-frame query batch
+struct FHandTeleportQuery
+{
+	bool bIsAiming = false;			// Teleport button held on this hand
+	bool bHasResult = false;		// An arc has been resolved since this hand last started needing one
+	bool bHasDestination = false;
+	FVector Start = FVector::ZeroVector;	// Pose the current arc was swept from
+	FVector Look = FVector::ZeroVector;
+	FVector HitLocation = FVector::ZeroVector;
+	FVector Destination = FVector::ZeroVector;
+	TArray<FVector> Path;
+	TArray<FVector> ArcPoints;		// Segment end points of the arc currently being swept
+	TArray<FTraceHandle> SweepHandles;	// One async sweep per arc segment, collected on the next frame
+	int32 LastHitSegment = INDEX_NONE;	// Segment the last collected arc hit on, used to cap the next submission
+	int32 FramesSinceSubmit = 0;
+};
+
 UCLASS()
 class ARCHITECTUREEXPLORER_API AVRCharacter : public ACharacter
 {
@@ -30,7 +48,14 @@ public:
 private:
 //------------------------------------------------------------------------------------------------------------------------------------------------------
 	// Functions used for Teleportation
-	bool FindTeleportDestination(TArray<FVector>& OutPath, FVector& OutLocation);
+	void RunHandQueryBatch();
+	void BuildTeleportArc(FHandTeleportQuery& Query, AHandController* Hand);
+	void CollectTeleportSweep(FHandTeleportQuery& Query, class UNavigationSystemV1* NavigationSystem);
+	void SweepTeleportArcNow(EControllerHand Hand);
+	void ApplyTeleportHit(FHandTeleportQuery& Query, int32 HitSegment, const FVector& HitLocation, class UNavigationSystemV1* NavigationSystem);
+	static int32 GetHandIndex(EControllerHand Hand) { return Hand == EControllerHand::Right ? 1 : 0; }
+	AHandController* GetHandController(int32 Index) const { return Index == 1 ? RightMotionController : LeftMotionController; }
+	FHandTeleportQuery& GetTeleportQuery(EControllerHand Hand) { return TeleportQueries[GetHandIndex(Hand)]; }
 	void UpdateDestinationMarker();
 	void StartFade(float FromAlpha, float ToAlpha);
 	void UpdateBlinkers();
@@ -46,6 +71,12 @@ private:
 	void ReleaseLeft() { LeftMotionController->Release(); }
 	void GripRight() { RightMotionController->Grip(); }
 	void ReleaseRight() { RightMotionController->Release(); }
+	void AimTeleportLeft() { AimTeleport(EControllerHand::Left); }
+	void AimTeleportRight() { AimTeleport(EControllerHand::Right); }
+	void ReleaseTeleportLeft() { ReleaseTeleport(EControllerHand::Left); }
+	void ReleaseTeleportRight() { ReleaseTeleport(EControllerHand::Right); }
+	void AimTeleport(EControllerHand Hand);
+	void ReleaseTeleport(EControllerHand Hand);
 	void BeginTelePort() ;
 	void EndTeleport();
 
@@ -98,7 +129,7 @@ private:
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------
 private:
-	// Variables to use with PrdictProjectilePath for Teleporting
+	// Variables used to build the parabolic arc that is swept for Teleporting
 	UPROPERTY(EditAnywhere)
 	float TeleportProjectileSpeed = 800.f;	
 
@@ -108,6 +139,15 @@ private:
 	UPROPERTY(EditAnywhere)
 	float TeleportSimulationTime = 1.f;
 
+	UPROPERTY(EditAnywhere)
+	float TeleportSimulationFrequency = 15.f;	// Arc segments per second of simulation, each one is an async sweep
+
+	UPROPERTY(EditAnywhere)
+	int32 TeleportSweepSegmentMargin = 2;	// Segments swept past the previous hit before the arc is cut short
+
+	UPROPERTY(EditAnywhere)
+	int32 TeleportSecondaryHandInterval = 4;	// Frames between arcs for a held hand that is not the previewed one
+
 //------------------------------------------------------------------------------------------------------------------------------------------------------
 	UPROPERTY(EditAnywhere)
 	float CameraFadeTime = 1.f;   // Variable used in StartCameraFade()
@@ -126,6 +166,9 @@ private:
 	float Radius = 0.f;	//	Used for setting the Radius of The Blinkers
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------
-	bool bCanTeleport = false;
-	
+	FVector TeleportDestination = FVector::ZeroVector;	// Destination of the hand that released teleport, used in EndTeleport()
+
+	FHandTeleportQuery TeleportQueries[2];	// Indexed by GetHandIndex(): Left, Right
+	EControllerHand ActiveTeleportHand = EControllerHand::Left;	// Hand whose arc is previewed and used to teleport
+
 };